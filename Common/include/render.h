@@ -0,0 +1,80 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RENDER_MAX_COMMANDS 512
+#define RENDER_TEXT_SIZE 2048
+
+typedef enum
+{
+    RENDER_FILL,
+    RENDER_RECT,
+    RENDER_IMAGE,
+    RENDER_TEXT,
+} RenderType;
+
+typedef struct
+{
+    RenderType type;
+    uint32_t color;
+    // Images store their scale in width/height
+    float x, y, width, height, angle;
+    // GRRLIB_texImg* for images, GRRLIB_ttfFont* for text
+    const void* handle;
+    uint16_t text, size;
+    uint8_t filled;
+} RenderCommand;
+
+typedef struct
+{
+    RenderCommand commands[RENDER_MAX_COMMANDS];
+    char text[RENDER_TEXT_SIZE];
+    int count, textUsed, dropped, quit;
+    uint32_t frame;
+} RenderList;
+
+typedef struct
+{
+    uint32_t frames, dropped;
+    // Microseconds. cpu is the game thread's update and recording time, submit the render thread's time issuing
+    // commands, gpu its time waiting for the GPU and vsync, and overlap the part of gpu the game spent running.
+    uint64_t cpu, submit, gpu, wait, elapsed, overlap;
+} RenderStats;
+
+// Starts the render stage. Must be called after GRRLIB_Init(); from then on only the render stage touches GX.
+// If the render thread can not be created, Render_End draws each list itself before returning.
+void Render_Init(void);
+// Draws every submitted list, then stops the render stage. Call before freeing textures or GRRLIB_Exit().
+void Render_Shutdown(void);
+
+// Waits until a list is free (the GPU has finished the frame before last) and starts recording into it
+void Render_Begin(void);
+// Publishes the recorded list to the render stage and returns without waiting for it to be drawn
+void Render_End(void);
+
+void Render_FillScreen(uint32_t color);
+void Render_Rectangle(float x, float y, float width, float height, uint32_t color, int filled);
+void Render_DrawImg(float x, float y, const void* texture, float angle, float scaleX, float scaleY, uint32_t color);
+void Render_Text(int x, int y, const void* font, const char* text, unsigned size, uint32_t color);
+
+RenderStats Render_GetStats(void);
+// Returns the index of the first command that differs between two lists, or -1 if they are identical
+int Render_DiffLists(const RenderList* a, const RenderList* b);
+
+#ifndef GEKKO
+// Host backend: called on the render stage in place of GX to record (and optionally time) each frame
+void Render_SetPresent(void (*present)(const RenderList* list));
+// Host backend: makes the next Render_Init run without a render thread, as if creating it had failed
+void Render_SetSynchronous(int synchronous);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SFX_H
+#define SFX_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SFX_SAMPLE_RATE 48000
+#define SFX_MAX_SOUNDS 32
+#define SFX_MAX_VOICES 8
+#define SFX_QUEUE_SIZE 64
+
+// ASND voice 0 is used by MP3Player, so effects start at voice 1
+#define SFX_FIRST_VOICE 1
+#define SFX_INVALID (-1)
+
+typedef int SFX_Sound;
+
+typedef enum
+{
+    SFX_WAVE_SQUARE,
+    SFX_WAVE_TRIANGLE,
+    SFX_WAVE_NOISE,
+} SFX_Wave;
+
+typedef struct
+{
+    uint32_t played, stolen, rejected, dropped;
+} SFX_Stats;
+
+// Must be called after ASND_Init()
+void SFX_Init(void);
+void SFX_Shutdown(void);
+
+// Decodes a RIFF WAV (8/16-bit PCM, mono/stereo) once into the PCM cache
+SFX_Sound SFX_LoadWAV(const void* data, long size);
+// Synthesizes a tone sweeping from startHz to endHz with a linear decay
+SFX_Sound SFX_LoadTone(SFX_Wave wave, float startHz, float endHz, int durationMs, int volume);
+
+// Queues a sound without allocating or blocking. Only call from a single (game) thread.
+// Higher priority sounds may steal voices from lower or equal priority ones when all voices are busy.
+// volume: 0-255, pan: -127 (left) to 127 (right)
+int SFX_Play(SFX_Sound sound, int priority, int volume, int pan);
+void SFX_StopAll(void);
+
+SFX_Stats SFX_GetStats(void);
+
+#ifndef GEKKO
+// Software mixer backend: drains the command queue and mixes interleaved stereo at SFX_SAMPLE_RATE
+void SFX_Mix(int16_t* out, int frames);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,374 @@
+#include "render.h"
+
+#include <string.h>
+
+#ifdef GEKKO
+#include <gccore.h>
+#include <ogc/lwp_watchdog.h>
+#include <grrlib.h>
+
+#define RENDER_STACK_SIZE (16 * 1024)
+#define RENDER_PRIORITY 80
+
+static lwp_t thread = LWP_THREAD_NULL;
+static sem_t freeLists, readyLists;
+static mutex_t statsLock;
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+static pthread_t thread;
+static sem_t freeLists, readyLists;
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+static void (*presentList)(const RenderList* list) = NULL;
+static int forceSynchronous = 0;
+#endif
+
+// Without a render thread (it could not be created) each list is drawn in Render_End instead
+static int threaded = 0;
+
+// Double-buffered: the game records into one list while the render stage draws the other
+static RenderList lists[2];
+static RenderList* recording = NULL;
+static int writeIndex = 0, readIndex = 0;
+
+// Shared by both stages, so only touched under statsLock (64-bit fields tear on the 32-bit Wii)
+static RenderStats stats;
+static uint64_t blockedSince = 0;
+static uint64_t beginTime = 0, lastEndTime = 0, firstEndTime = 0;
+
+static uint64_t now(void)
+{
+#ifdef GEKKO
+    return ticks_to_microsecs(gettime());
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+#endif
+}
+
+static void waitFence(sem_t* fence)
+{
+#ifdef GEKKO
+    LWP_SemWait(*fence);
+#else
+    while (sem_wait(fence) != 0);
+#endif
+}
+
+static void signalFence(sem_t* fence)
+{
+#ifdef GEKKO
+    LWP_SemPost(*fence);
+#else
+    sem_post(fence);
+#endif
+}
+
+static void lockStats(void)
+{
+#ifdef GEKKO
+    LWP_MutexLock(statsLock);
+#else
+    pthread_mutex_lock(&statsLock);
+#endif
+}
+
+static void unlockStats(void)
+{
+#ifdef GEKKO
+    LWP_MutexUnlock(statsLock);
+#else
+    pthread_mutex_unlock(&statsLock);
+#endif
+}
+
+// Issues the list's commands; this is CPU work, even on the render thread
+static void submitList(const RenderList* list)
+{
+#ifdef GEKKO
+    for (int i = 0; i < list->count; ++i)
+    {
+        const RenderCommand* c = &list->commands[i];
+        switch (c->type)
+        {
+            case RENDER_FILL:
+                GRRLIB_FillScreen(c->color);
+                break;
+            case RENDER_RECT:
+                GRRLIB_Rectangle(c->x, c->y, c->width, c->height, c->color, c->filled);
+                break;
+            case RENDER_IMAGE:
+                GRRLIB_DrawImg(c->x, c->y, c->handle, c->angle, c->width, c->height, c->color);
+                break;
+            case RENDER_TEXT:
+                GRRLIB_PrintfTTF((int)c->x, (int)c->y, (GRRLIB_ttfFont*)c->handle, list->text + c->text, c->size,
+                                 c->color);
+                break;
+        }
+    }
+#else
+    (void)list;
+#endif
+}
+
+// Waits for the GPU to finish the frame and for vsync; the CPU is free for the game meanwhile
+static void presentFrame(const RenderList* list)
+{
+#ifdef GEKKO
+    (void)list;
+    GRRLIB_Render();
+#else
+    if (presentList) presentList(list);
+#endif
+}
+
+// Draws the next ready list and hands it back to the game
+static void drawList(void)
+{
+    const RenderList* list = &lists[readIndex];
+
+    const uint64_t start = now();
+    submitList(list);
+    const uint64_t submitted = now();
+    presentFrame(list);
+    const uint64_t presented = now();
+
+    // The game only stops running while it is blocked on a free list, which can not end before we signal one
+    lockStats();
+    uint64_t blocked = 0;
+    if (blockedSince && blockedSince < presented)
+        blocked = presented - (blockedSince > submitted ? blockedSince : submitted);
+    stats.submit += submitted - start;
+    stats.gpu += presented - submitted;
+    stats.overlap += presented - submitted - blocked;
+    unlockStats();
+
+    readIndex ^= 1;
+    signalFence(&freeLists);
+}
+
+static void* renderThread(void* arg)
+{
+    (void)arg;
+#ifdef GEKKO
+    // The FIFO high-watermark interrupt suspends the GX thread, which must be the one writing to the FIFO
+    GX_SetCurrentGXThread();
+#endif
+
+    while (1)
+    {
+        waitFence(&readyLists);
+        if (lists[readIndex].quit) break;
+        drawList();
+    }
+
+    return NULL;
+}
+
+void Render_Init(void)
+{
+    memset(lists, 0, sizeof(lists));
+    memset(&stats, 0, sizeof(stats));
+    recording = NULL;
+    writeIndex = readIndex = 0;
+    beginTime = lastEndTime = firstEndTime = 0;
+
+#ifdef GEKKO
+    LWP_MutexInit(&statsLock, false);
+    LWP_SemInit(&freeLists, 2, 2);
+    LWP_SemInit(&readyLists, 0, 2);
+    threaded = LWP_CreateThread(&thread, renderThread, NULL, NULL, RENDER_STACK_SIZE, RENDER_PRIORITY) == 0;
+    if (!threaded) thread = LWP_THREAD_NULL;
+#else
+    sem_init(&freeLists, 0, 2);
+    sem_init(&readyLists, 0, 0);
+    threaded = !forceSynchronous && pthread_create(&thread, NULL, renderThread, NULL) == 0;
+#endif
+}
+
+void Render_Shutdown(void)
+{
+    // Queue a sentinel list so everything recorded before it is still drawn
+    if (threaded)
+    {
+        waitFence(&freeLists);
+        lists[writeIndex].quit = 1;
+        signalFence(&readyLists);
+    }
+
+#ifdef GEKKO
+    if (threaded) LWP_JoinThread(thread, NULL);
+    thread = LWP_THREAD_NULL;
+    LWP_SemDestroy(freeLists);
+    LWP_SemDestroy(readyLists);
+    LWP_MutexDestroy(statsLock);
+
+    // Freeing textures and GRRLIB_Exit() use GX from this thread again
+    GX_SetCurrentGXThread();
+#else
+    if (threaded) pthread_join(thread, NULL);
+    sem_destroy(&freeLists);
+    sem_destroy(&readyLists);
+#endif
+}
+
+void Render_Begin(void)
+{
+    const uint64_t start = now();
+    lockStats();
+    if (lastEndTime) stats.cpu += start - lastEndTime;
+    blockedSince = start;
+    unlockStats();
+
+    waitFence(&freeLists);
+    beginTime = now();
+
+    lockStats();
+    blockedSince = 0;
+    stats.wait += beginTime - start;
+    const uint32_t frame = stats.frames;
+    unlockStats();
+
+    recording = &lists[writeIndex];
+    recording->count = 0;
+    recording->textUsed = 0;
+    recording->dropped = 0;
+    recording->quit = 0;
+    recording->frame = frame;
+}
+
+void Render_End(void)
+{
+    const uint64_t end = now();
+    if (!firstEndTime) firstEndTime = end;
+
+    lockStats();
+    stats.cpu += end - beginTime;
+    stats.dropped += (uint32_t)recording->dropped;
+    stats.elapsed = end - firstEndTime;
+    stats.frames++;
+    unlockStats();
+
+    recording = NULL;
+    writeIndex ^= 1;
+    if (threaded)
+    {
+        lastEndTime = end;
+        signalFence(&readyLists);
+        return;
+    }
+
+    // Drawing blocks the game here, so none of it overlaps and none of it counts as update time
+    lockStats();
+    blockedSince = end;
+    unlockStats();
+    drawList();
+    lockStats();
+    blockedSince = 0;
+    unlockStats();
+    lastEndTime = now();
+}
+
+static RenderCommand* pushCommand(RenderType type, uint32_t color)
+{
+    if (!recording) return NULL;
+    if (recording->count >= RENDER_MAX_COMMANDS)
+    {
+        recording->dropped++;
+        return NULL;
+    }
+
+    RenderCommand* c = &recording->commands[recording->count++];
+    memset(c, 0, sizeof(*c));
+    c->type = type;
+    c->color = color;
+
+    return c;
+}
+
+void Render_FillScreen(uint32_t color) { pushCommand(RENDER_FILL, color); }
+
+void Render_Rectangle(float x, float y, float width, float height, uint32_t color, int filled)
+{
+    RenderCommand* c = pushCommand(RENDER_RECT, color);
+    if (!c) return;
+
+    c->x = x;
+    c->y = y;
+    c->width = width;
+    c->height = height;
+    c->filled = filled != 0;
+}
+
+void Render_DrawImg(float x, float y, const void* texture, float angle, float scaleX, float scaleY, uint32_t color)
+{
+    RenderCommand* c = pushCommand(RENDER_IMAGE, color);
+    if (!c) return;
+
+    c->x = x;
+    c->y = y;
+    c->width = scaleX;
+    c->height = scaleY;
+    c->angle = angle;
+    c->handle = texture;
+}
+
+void Render_Text(int x, int y, const void* font, const char* text, unsigned size, uint32_t color)
+{
+    if (!recording) return;
+
+    // Text is copied into the list so callers can reuse their buffers straight away
+    const int length = (int)strlen(text) + 1;
+    if (recording->textUsed + length > RENDER_TEXT_SIZE)
+    {
+        recording->dropped++;
+        return;
+    }
+
+    RenderCommand* c = pushCommand(RENDER_TEXT, color);
+    if (!c) return;
+
+    memcpy(recording->text + recording->textUsed, text, (size_t)length);
+    c->x = (float)x;
+    c->y = (float)y;
+    c->handle = font;
+    c->text = (uint16_t)recording->textUsed;
+    c->size = (uint16_t)size;
+    recording->textUsed += length;
+}
+
+RenderStats Render_GetStats(void)
+{
+    lockStats();
+    const RenderStats out = stats;
+    unlockStats();
+
+    return out;
+}
+
+int Render_DiffLists(const RenderList* a, const RenderList* b)
+{
+    const int count = a->count < b->count ? a->count : b->count;
+    for (int i = 0; i < count; ++i)
+    {
+        const RenderCommand* x = &a->commands[i];
+        const RenderCommand* y = &b->commands[i];
+
+        if (x->type != y->type || x->color != y->color || x->x != y->x || x->y != y->y || x->width != y->width ||
+            x->height != y->height || x->angle != y->angle || x->handle != y->handle || x->size != y->size ||
+            x->filled != y->filled)
+            return i;
+        if (x->type == RENDER_TEXT && strcmp(a->text + x->text, b->text + y->text) != 0) return i;
+    }
+
+    return a->count == b->count ? -1 : count;
+}
+
+#ifndef GEKKO
+void Render_SetPresent(void (*present)(const RenderList* list)) { presentList = present; }
+
+void Render_SetSynchronous(int synchronous) { forceSynchronous = synchronous; }
+#endif
@@ -0,0 +1,428 @@
+#include "sfx.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef GEKKO
+#include <malloc.h>
+#include <gccore.h>
+#include <asndlib.h>
+#endif
+
+#define SFX_ALIGN 32
+#define SFX_MIX_CHUNK 256
+#define SFX_STOP_ALL (-2)
+
+typedef struct
+{
+    int16_t* samples;
+    uint32_t frames, bytes;
+    int rate, channels;
+} Sound;
+
+typedef struct
+{
+    int sound, priority, volume, pan;
+} Command;
+
+typedef struct
+{
+    int sound, priority;
+    uint32_t stamp;
+#ifndef GEKKO
+    int active, volumeLeft, volumeRight;
+    // 16.16 fixed point; 64 bits so sounds longer than 65536 frames still reach their end
+    uint64_t position;
+    uint32_t step;
+#endif
+} Voice;
+
+static Sound sounds[SFX_MAX_SOUNDS];
+static int soundCount = 0;
+
+static Voice voices[SFX_MAX_VOICES];
+static uint32_t voiceStamp = 0;
+
+// Single-producer/single-consumer ring: the game thread pushes, the audio side pops
+static Command queue[SFX_QUEUE_SIZE];
+static uint32_t queueHead = 0, queueTail = 0;
+
+// Written by the consumer only; dropped commands are counted separately by the producer
+static SFX_Stats stats;
+static uint32_t dropped = 0;
+
+// Each counter has a single writer, so a relaxed load/store pair is enough to keep readers from tearing it
+static void count(uint32_t* counter)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+static int pushCommand(const Command* command)
+{
+    const uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_RELAXED);
+    const uint32_t tail = __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+    if (head - tail >= SFX_QUEUE_SIZE)
+    {
+        count(&dropped);
+        return 0;
+    }
+
+    queue[head & (SFX_QUEUE_SIZE - 1)] = *command;
+    __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+
+    return 1;
+}
+
+static int popCommand(Command* command)
+{
+    const uint32_t tail = __atomic_load_n(&queueTail, __ATOMIC_RELAXED);
+    const uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE);
+    if (head == tail) return 0;
+
+    *command = queue[tail & (SFX_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queueTail, tail + 1, __ATOMIC_RELEASE);
+
+    return 1;
+}
+
+static void* allocAligned(size_t size)
+{
+#ifdef GEKKO
+    return memalign(SFX_ALIGN, size);
+#else
+    return aligned_alloc(SFX_ALIGN, size);
+#endif
+}
+
+static int16_t* allocSound(SFX_Sound* out, uint64_t frames, int channels, int rate)
+{
+    if (soundCount >= SFX_MAX_SOUNDS || frames == 0) return NULL;
+
+    // ASND DMAs whole 32-byte blocks, so pad the tail with silence
+    const uint64_t size = (frames * (uint64_t)channels * sizeof(int16_t) + SFX_ALIGN - 1) & ~(uint64_t)(SFX_ALIGN - 1);
+    if (size > UINT32_MAX) return NULL;
+
+    const uint32_t bytes = (uint32_t)size;
+    int16_t* samples = allocAligned(bytes);
+    if (!samples) return NULL;
+    memset(samples, 0, bytes);
+
+    Sound* sound = &sounds[soundCount];
+    sound->samples = samples;
+    sound->frames = (uint32_t)frames;
+    sound->bytes = bytes;
+    sound->rate = rate;
+    sound->channels = channels;
+    *out = soundCount++;
+
+    return samples;
+}
+
+static void commitSound(SFX_Sound sound)
+{
+#ifdef GEKKO
+    DCFlushRange(sounds[sound].samples, sounds[sound].bytes);
+#else
+    (void)sound;
+#endif
+}
+
+static uint32_t readLE(const uint8_t* p, int bytes)
+{
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) value = value << 8 | p[i];
+
+    return value;
+}
+
+SFX_Sound SFX_LoadWAV(const void* data, long size)
+{
+    const uint8_t* bytes = data;
+    if (!bytes || size < 12 || memcmp(bytes, "RIFF", 4) != 0 || memcmp(bytes + 8, "WAVE", 4) != 0)
+        return SFX_INVALID;
+
+    const uint8_t* pcm = NULL;
+    uint32_t pcmSize = 0;
+    int format = 0, channels = 0, rate = 0, bits = 0;
+
+    long offset = 12;
+    while (offset + 8 <= size)
+    {
+        const uint8_t* chunk = bytes + offset;
+        const uint32_t chunkSize = readLE(chunk + 4, 4);
+        if (chunkSize > (uint32_t)(size - offset - 8)) break;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            format = (int)readLE(chunk + 8, 2);
+            channels = (int)readLE(chunk + 10, 2);
+            rate = (int)readLE(chunk + 12, 4);
+            bits = (int)readLE(chunk + 22, 2);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            pcm = chunk + 8;
+            pcmSize = chunkSize;
+        }
+
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (!pcm || format != 1 || channels < 1 || channels > 2 || rate <= 0 || (bits != 8 && bits != 16))
+        return SFX_INVALID;
+
+    const uint32_t frames = pcmSize / (channels * (bits / 8));
+    SFX_Sound sound = SFX_INVALID;
+    int16_t* samples = allocSound(&sound, frames, channels, rate);
+    if (!samples) return SFX_INVALID;
+
+    // Convert to native-endian signed 16-bit, which is what ASND expects on the Wii
+    for (uint32_t i = 0; i < frames * channels; ++i)
+        samples[i] = bits == 8 ? (int16_t)((pcm[i] - 128) << 8) : (int16_t)readLE(pcm + i * 2, 2);
+
+    commitSound(sound);
+    return sound;
+}
+
+SFX_Sound SFX_LoadTone(SFX_Wave wave, float startHz, float endHz, int durationMs, int volume)
+{
+    if (durationMs <= 0) return SFX_INVALID;
+
+    SFX_Sound sound = SFX_INVALID;
+    int16_t* samples = allocSound(&sound, (uint64_t)SFX_SAMPLE_RATE * (uint64_t)durationMs / 1000, 1, SFX_SAMPLE_RATE);
+    if (!samples) return SFX_INVALID;
+
+    const uint32_t frames = sounds[sound].frames;
+
+    const float amplitude = (float)(volume < 0 ? 0 : volume > 255 ? 255 : volume) * 32767.0f / 255.0f;
+    uint32_t seed = 0x1234567u;
+    float phase = 0, noise = 0;
+
+    for (uint32_t i = 0; i < frames; ++i)
+    {
+        const float t = (float)i / (float)frames;
+        phase += (startHz + (endHz - startHz) * t) / SFX_SAMPLE_RATE;
+        if (phase >= 1.0f)
+        {
+            phase -= floorf(phase);
+            seed = seed * 1664525u + 1013904223u;
+            noise = (float)(seed >> 16) / 32767.5f - 1.0f;
+        }
+
+        float value;
+        switch (wave)
+        {
+            case SFX_WAVE_TRIANGLE:
+                value = 4.0f * fabsf(phase - 0.5f) - 1.0f;
+                break;
+            case SFX_WAVE_NOISE:
+                value = noise;
+                break;
+            default:
+                value = phase < 0.5f ? 1.0f : -1.0f;
+                break;
+        }
+
+        samples[i] = (int16_t)(value * (1.0f - t) * amplitude);
+    }
+
+    commitSound(sound);
+    return sound;
+}
+
+static void panVolume(const Command* command, int* left, int* right)
+{
+    const int volume = command->volume < 0 ? 0 : command->volume > 255 ? 255 : command->volume;
+    const int pan = command->pan < -127 ? -127 : command->pan > 127 ? 127 : command->pan;
+
+    *left = pan > 0 ? volume * (127 - pan) / 127 : volume;
+    *right = pan < 0 ? volume * (127 + pan) / 127 : volume;
+}
+
+static int isVoiceBusy(int voice)
+{
+#ifdef GEKKO
+    return ASND_StatusVoice(SFX_FIRST_VOICE + voice) != SND_UNUSED;
+#else
+    return voices[voice].active;
+#endif
+}
+
+static void stopVoice(int voice)
+{
+#ifdef GEKKO
+    ASND_StopVoice(SFX_FIRST_VOICE + voice);
+#else
+    voices[voice].active = 0;
+#endif
+}
+
+// Returns a free voice, or else the lowest priority (then oldest) voice not above the requested priority
+static int pickVoice(int priority)
+{
+    int victim = -1;
+    for (int i = 0; i < SFX_MAX_VOICES; ++i)
+    {
+        if (!isVoiceBusy(i)) return i;
+        if (voices[i].priority > priority) continue;
+
+        if (victim < 0 || voices[i].priority < voices[victim].priority ||
+            (voices[i].priority == voices[victim].priority && (int32_t)(voices[i].stamp - voices[victim].stamp) < 0))
+            victim = i;
+    }
+
+    if (victim >= 0) count(&stats.stolen);
+    return victim;
+}
+
+static void startVoice(int voice, const Command* command)
+{
+    const Sound* sound = &sounds[command->sound];
+    int left, right;
+    panVolume(command, &left, &right);
+
+    stopVoice(voice);
+    voices[voice].sound = command->sound;
+    voices[voice].priority = command->priority;
+    voices[voice].stamp = voiceStamp++;
+
+#ifdef GEKKO
+    ASND_SetVoice(SFX_FIRST_VOICE + voice, sound->channels == 2 ? VOICE_STEREO_16BIT : VOICE_MONO_16BIT, sound->rate,
+                  0, sound->samples, (s32)sound->bytes, left, right, NULL);
+#else
+    voices[voice].volumeLeft = left;
+    voices[voice].volumeRight = right;
+    voices[voice].position = 0;
+    voices[voice].step = (uint32_t)(((uint64_t)sound->rate << 16) / SFX_SAMPLE_RATE);
+    voices[voice].active = 1;
+#endif
+    count(&stats.played);
+}
+
+// Consumer side: runs from the ASND callback on the Wii and from SFX_Mix on the host
+static void processCommands(void)
+{
+    Command command;
+    while (popCommand(&command))
+    {
+        if (command.sound == SFX_STOP_ALL)
+        {
+            for (int i = 0; i < SFX_MAX_VOICES; ++i) stopVoice(i);
+            continue;
+        }
+
+        const int voice = pickVoice(command.priority);
+        if (voice < 0)
+        {
+            count(&stats.rejected);
+            continue;
+        }
+
+        startVoice(voice, &command);
+    }
+}
+
+void SFX_Init(void)
+{
+    memset(voices, 0, sizeof(voices));
+    memset(&stats, 0, sizeof(stats));
+    __atomic_store_n(&dropped, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queueHead, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queueTail, 0, __ATOMIC_RELAXED);
+
+#ifdef GEKKO
+    ASND_SetCallback(processCommands);
+    ASND_Pause(0);
+#endif
+}
+
+void SFX_Shutdown(void)
+{
+#ifdef GEKKO
+    ASND_SetCallback(NULL);
+#endif
+    for (int i = 0; i < SFX_MAX_VOICES; ++i) stopVoice(i);
+
+    for (int i = 0; i < soundCount; ++i) free(sounds[i].samples);
+    memset(sounds, 0, sizeof(sounds));
+    soundCount = 0;
+}
+
+int SFX_Play(SFX_Sound sound, int priority, int volume, int pan)
+{
+    if (sound < 0 || sound >= soundCount) return 0;
+
+    const Command command = {sound, priority, volume, pan};
+    return pushCommand(&command);
+}
+
+void SFX_StopAll(void)
+{
+    const Command command = {SFX_STOP_ALL, 0, 0, 0};
+    pushCommand(&command);
+}
+
+SFX_Stats SFX_GetStats(void)
+{
+    SFX_Stats out;
+#ifdef GEKKO
+    // The consumer counters are updated from the ASND interrupt
+    u32 level;
+    _CPU_ISR_Disable(level);
+    out = stats;
+    _CPU_ISR_Restore(level);
+#else
+    out.played = __atomic_load_n(&stats.played, __ATOMIC_RELAXED);
+    out.stolen = __atomic_load_n(&stats.stolen, __ATOMIC_RELAXED);
+    out.rejected = __atomic_load_n(&stats.rejected, __ATOMIC_RELAXED);
+#endif
+    out.dropped = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+
+    return out;
+}
+
+#ifndef GEKKO
+static int16_t clampSample(int32_t value)
+{
+    return (int16_t)(value > 32767 ? 32767 : value < -32768 ? -32768 : value);
+}
+
+void SFX_Mix(int16_t* out, int frames)
+{
+    static int32_t mix[SFX_MIX_CHUNK * 2];
+    processCommands();
+
+    while (frames > 0)
+    {
+        const int count = frames < SFX_MIX_CHUNK ? frames : SFX_MIX_CHUNK;
+        memset(mix, 0, sizeof(int32_t) * count * 2);
+
+        for (int v = 0; v < SFX_MAX_VOICES; ++v)
+        {
+            Voice* voice = &voices[v];
+            if (!voice->active) continue;
+
+            const Sound* sound = &sounds[voice->sound];
+            for (int i = 0; i < count; ++i)
+            {
+                const uint64_t index = voice->position >> 16;
+                if (index >= sound->frames)
+                {
+                    voice->active = 0;
+                    break;
+                }
+
+                const int16_t* frame = sound->samples + index * sound->channels;
+                mix[i * 2] += frame[0] * voice->volumeLeft >> 8;
+                mix[i * 2 + 1] += frame[sound->channels - 1] * voice->volumeRight >> 8;
+                voice->position += voice->step;
+            }
+        }
+
+        for (int i = 0; i < count * 2; ++i) out[i] = clampSample(mix[i]);
+        out += count * 2;
+        frames -= count;
+    }
+}
+#endif
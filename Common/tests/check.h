@@ -0,0 +1,37 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                                       \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                                     \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        const long long a_ = (long long)(actual), e_ = (long long)(expected);                                          \
+        if (a_ != e_)                                                                                                  \
+        {                                                                                                              \
+            printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_);                         \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+#define RUN(test)                                                                                                      \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        const int before_ = failures;                                                                                  \
+        test();                                                                                                        \
+        printf("%s %s\n", failures == before_ ? "PASS" : "FAIL", #test);                                               \
+    } while (0)
+
+#endif
@@ -0,0 +1,168 @@
+#include <string.h>
+#include <time.h>
+
+#include <render.h>
+
+#include "check.h"
+
+#define MAX_RECORDED 16
+
+static RenderList recorded[MAX_RECORDED];
+static int recordedCount = 0;
+static long presentDelayUs = 0;
+
+static void sleepUs(long us)
+{
+    const struct timespec ts = {us / 1000000, us % 1000000 * 1000};
+    nanosleep(&ts, NULL);
+}
+
+// Stands in for the GPU: records the list, then takes presentDelayUs to "draw" it
+static void present(const RenderList* list)
+{
+    if (recordedCount < MAX_RECORDED) recorded[recordedCount++] = *list;
+    if (presentDelayUs) sleepUs(presentDelayUs);
+}
+
+static void start(long delayUs)
+{
+    recordedCount = 0;
+    presentDelayUs = delayUs;
+    Render_SetPresent(present);
+    Render_Init();
+}
+
+static void frame(float height, const char* text, int extra)
+{
+    Render_Begin();
+    Render_FillScreen(0x000000FF);
+    Render_Rectangle(1, 2, 3, height, 0xFFFFFFFF, 1);
+    Render_Text(10, 10, NULL, text, 24, 0xFFFFFFFF);
+    if (extra) Render_DrawImg(5, 5, &recordedCount, 0, 1, 1, 0xFFFFFFFF);
+    Render_End();
+}
+
+static void test_record_and_diff(void)
+{
+    start(0);
+    frame(4, "Score: 1", 0);
+    frame(5, "Score: 1", 0);
+    frame(4, "Score: 2", 0);
+    frame(4, "Score: 1", 0);
+    frame(4, "Score: 1", 1);
+    Render_Shutdown();
+
+    CHECK_EQ(recordedCount, 5);
+    for (int i = 0; i < recordedCount; ++i) CHECK_EQ(recorded[i].frame, i);
+
+    CHECK_EQ(recorded[0].count, 3);
+    CHECK_EQ(recorded[0].commands[1].type, RENDER_RECT);
+    CHECK(strcmp(recorded[0].text + recorded[0].commands[2].text, "Score: 1") == 0);
+
+    CHECK_EQ(Render_DiffLists(&recorded[0], &recorded[3]), -1);
+    CHECK_EQ(Render_DiffLists(&recorded[0], &recorded[0]), -1);
+    CHECK_EQ(Render_DiffLists(&recorded[0], &recorded[1]), 1);
+    CHECK_EQ(Render_DiffLists(&recorded[0], &recorded[2]), 2);
+    CHECK_EQ(Render_DiffLists(&recorded[0], &recorded[4]), 3);
+    CHECK_EQ(Render_DiffLists(&recorded[4], &recorded[0]), 3);
+}
+
+static void test_dropping(void)
+{
+    start(0);
+
+    Render_Begin();
+    for (int i = 0; i < RENDER_MAX_COMMANDS + 3; ++i) Render_Rectangle((float)i, 0, 1, 1, 0xFFFFFFFF, 1);
+    Render_End();
+
+    // 99 characters plus the terminator: 20 fit in the text arena
+    char text[100];
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    Render_Begin();
+    for (int i = 0; i < 25; ++i) Render_Text(0, i, NULL, text, 12, 0xFFFFFFFF);
+    text[0] = 'b';
+    Render_End();
+    Render_Shutdown();
+
+    CHECK_EQ(recordedCount, 2);
+    CHECK_EQ(recorded[0].count, RENDER_MAX_COMMANDS);
+    CHECK_EQ(recorded[0].dropped, 3);
+    CHECK_EQ(recorded[1].count, RENDER_TEXT_SIZE / 100);
+    CHECK_EQ(recorded[1].dropped, 25 - RENDER_TEXT_SIZE / 100);
+    CHECK_EQ(recorded[1].text[0], 'a');
+    CHECK_EQ(Render_GetStats().dropped, 3 + 25 - RENDER_TEXT_SIZE / 100);
+}
+
+static void test_shutdown_draws_everything(void)
+{
+    start(5000);
+    for (int i = 0; i < 6; ++i) frame((float)i, "x", 0);
+    Render_Shutdown();
+
+    CHECK_EQ(recordedCount, 6);
+    for (int i = 0; i < recordedCount; ++i) CHECK_EQ(recorded[i].commands[1].height, i);
+    CHECK_EQ(Render_GetStats().frames, 6);
+}
+
+static void test_overlap(void)
+{
+    // 10 ms of update per frame against 10 ms of GPU time: pipelined, a frame costs about 10 ms rather than 20
+    start(10000);
+    for (int i = 0; i < 10; ++i)
+    {
+        sleepUs(10000);
+        frame(1, "x", 0);
+    }
+    Render_Shutdown();
+
+    const RenderStats busy = Render_GetStats();
+    CHECK(busy.gpu >= 90000);
+    CHECK(busy.overlap >= busy.gpu / 2);
+    CHECK(busy.overlap <= busy.gpu);
+    CHECK(busy.elapsed < (busy.cpu + busy.gpu) * 8 / 10);
+
+    // With no update work the game just waits on the fences, so nothing overlaps
+    start(10000);
+    for (int i = 0; i < 10; ++i) frame(1, "x", 0);
+    Render_Shutdown();
+
+    const RenderStats idle = Render_GetStats();
+    CHECK(idle.wait >= 50000);
+    CHECK(idle.overlap < idle.gpu / 4);
+}
+
+static void test_synchronous(void)
+{
+    // As when the render thread can not be created: every list is drawn before Render_End returns
+    Render_SetSynchronous(1);
+    start(2000);
+    for (int i = 0; i < 5; ++i)
+    {
+        frame((float)i, "x", 0);
+        CHECK_EQ(recordedCount, i + 1);
+    }
+    Render_Shutdown();
+    Render_SetSynchronous(0);
+
+    CHECK_EQ(recordedCount, 5);
+    for (int i = 0; i < recordedCount; ++i) CHECK_EQ(recorded[i].commands[1].height, i);
+
+    const RenderStats sync = Render_GetStats();
+    CHECK_EQ(sync.frames, 5);
+    CHECK(sync.gpu >= 10000);
+    CHECK_EQ(sync.overlap, 0);
+    CHECK(sync.cpu < sync.gpu);
+}
+
+int main(void)
+{
+    RUN(test_record_and_diff);
+    RUN(test_dropping);
+    RUN(test_shutdown_draws_everything);
+    RUN(test_overlap);
+    RUN(test_synchronous);
+
+    return failures ? 1 : 0;
+}
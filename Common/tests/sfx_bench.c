@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <time.h>
+
+#include <sfx.h>
+
+#define FRAMES SFX_SAMPLE_RATE
+#define ROUNDS 20
+
+static int16_t out[2 * 1024];
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Mixes one second of audio with 0-8 busy voices and reports the cost each voice adds per output frame
+int main(void)
+{
+    SFX_Init();
+    const SFX_Sound native = SFX_LoadTone(SFX_WAVE_SQUARE, 440, 880, 1100, 255);
+    const SFX_Sound resampled = SFX_LoadTone(SFX_WAVE_NOISE, 2000, 200, 1100, 255);
+
+    double idle = 0;
+    printf("%6s %12s %16s\n", "voices", "ms/second", "ns/voice/frame");
+    for (int voices = 0; voices <= SFX_MAX_VOICES; ++voices)
+    {
+        double elapsed = 0;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            SFX_StopAll();
+            for (int v = 0; v < voices; ++v) SFX_Play(v & 1 ? resampled : native, 0, 200, v * 30 - 120);
+
+            const double start = seconds();
+            for (int done = 0; done < FRAMES; done += 1024) SFX_Mix(out, FRAMES - done < 1024 ? FRAMES - done : 1024);
+            elapsed += seconds() - start;
+        }
+
+        elapsed /= ROUNDS;
+        if (voices == 0) idle = elapsed;
+        printf("%6d %12.3f %16.2f\n", voices, elapsed * 1e3, voices ? (elapsed - idle) * 1e9 / voices / FRAMES : 0.0);
+    }
+
+    SFX_Shutdown();
+    return 0;
+}
@@ -0,0 +1,271 @@
+#include <string.h>
+
+#include <sfx.h>
+
+#include "check.h"
+
+static uint8_t wav[44 + 4 * 48000];
+static int16_t out[2 * 1024];
+
+static void reset(void)
+{
+    SFX_Shutdown();
+    SFX_Init();
+}
+
+static void put(uint8_t* p, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) p[i] = (uint8_t)(value >> (8 * i));
+}
+
+// Builds a PCM WAV where every frame holds the same left/right sample
+static long makeWav(int rate, int channels, int bits, uint32_t frames, int left, int right)
+{
+    const uint32_t dataSize = frames * channels * (bits / 8);
+    memcpy(wav, "RIFF", 4);
+    put(wav + 4, 36 + dataSize, 4);
+    memcpy(wav + 8, "WAVEfmt ", 8);
+    put(wav + 16, 16, 4);
+    put(wav + 20, 1, 2);
+    put(wav + 22, channels, 2);
+    put(wav + 24, rate, 4);
+    put(wav + 28, rate * channels * (bits / 8), 4);
+    put(wav + 32, channels * (bits / 8), 2);
+    put(wav + 34, bits, 2);
+    memcpy(wav + 36, "data", 4);
+    put(wav + 40, dataSize, 4);
+
+    uint8_t* p = wav + 44;
+    for (uint32_t i = 0; i < frames; ++i)
+        for (int c = 0; c < channels; ++c)
+        {
+            const int value = c == 0 ? left : right;
+            if (bits == 8) *p++ = (uint8_t)value;
+            else
+            {
+                put(p, (uint16_t)value, 2);
+                p += 2;
+            }
+        }
+
+    return 44 + (long)dataSize;
+}
+
+static SFX_Sound constant(int value, uint32_t frames)
+{
+    return SFX_LoadWAV(wav, makeWav(SFX_SAMPLE_RATE, 1, 16, frames, value, value));
+}
+
+static int level(int value, int volume) { return value * volume >> 8; }
+
+static void test_volume_and_pan(void)
+{
+    reset();
+    const SFX_Sound sound = constant(4096, 1000);
+    CHECK(sound != SFX_INVALID);
+
+    SFX_Play(sound, 0, 255, 0);
+    SFX_Mix(out, 4);
+    CHECK_EQ(out[0], level(4096, 255));
+    CHECK_EQ(out[1], level(4096, 255));
+
+    SFX_StopAll();
+    SFX_Play(sound, 0, 255, 127);
+    SFX_Mix(out, 4);
+    CHECK_EQ(out[0], 0);
+    CHECK_EQ(out[1], level(4096, 255));
+
+    SFX_StopAll();
+    SFX_Play(sound, 0, 300, -200);
+    SFX_Mix(out, 4);
+    CHECK_EQ(out[0], level(4096, 255));
+    CHECK_EQ(out[1], 0);
+
+    SFX_StopAll();
+    SFX_Play(sound, 0, 128, 63);
+    SFX_Mix(out, 4);
+    CHECK_EQ(out[0], level(4096, 128 * 64 / 127));
+    CHECK_EQ(out[1], level(4096, 128));
+}
+
+static void test_resampling(void)
+{
+    reset();
+    // 100 frames at 24 kHz last 200 output frames at 48 kHz
+    const SFX_Sound sound = SFX_LoadWAV(wav, makeWav(24000, 1, 16, 100, 1000, 1000));
+    SFX_Play(sound, 0, 255, 0);
+    SFX_Mix(out, 300);
+
+    CHECK_EQ(out[0], level(1000, 255));
+    CHECK_EQ(out[199 * 2], level(1000, 255));
+    CHECK_EQ(out[200 * 2], 0);
+    CHECK_EQ(out[299 * 2 + 1], 0);
+
+    SFX_Mix(out, 10);
+    CHECK_EQ(out[0], 0);
+}
+
+static void test_formats(void)
+{
+    reset();
+    const SFX_Sound sound = SFX_LoadWAV(wav, makeWav(SFX_SAMPLE_RATE, 2, 8, 64, 0xC0, 0x40));
+    CHECK(sound != SFX_INVALID);
+
+    SFX_Play(sound, 0, 255, 0);
+    SFX_Mix(out, 2);
+    CHECK_EQ(out[0], level(16384, 255));
+    CHECK_EQ(out[1], level(-16384, 255));
+
+    const char junk[64] = "RIFF....WAVEjunk";
+    CHECK_EQ(SFX_LoadWAV(junk, sizeof(junk)), SFX_INVALID);
+    CHECK_EQ(SFX_LoadWAV(NULL, 0), SFX_INVALID);
+    CHECK_EQ(SFX_Play(SFX_INVALID, 0, 255, 0), 0);
+}
+
+static void test_clamping(void)
+{
+    reset();
+    const SFX_Sound high = constant(30000, 1000);
+    const SFX_Sound low = constant(-30000, 1000);
+
+    for (int i = 0; i < SFX_MAX_VOICES; ++i) SFX_Play(high, 0, 255, 0);
+    SFX_Mix(out, 2);
+    CHECK_EQ(out[0], 32767);
+
+    SFX_StopAll();
+    for (int i = 0; i < SFX_MAX_VOICES; ++i) SFX_Play(low, 0, 255, 0);
+    SFX_Mix(out, 2);
+    CHECK_EQ(out[1], -32768);
+}
+
+// Fills every voice with a distinct level, plays one more sound and returns which voice was replaced
+static int stealFrom(const int* priorities, int priority)
+{
+    reset();
+    SFX_Sound sounds[SFX_MAX_VOICES + 1];
+    for (int i = 0; i <= SFX_MAX_VOICES; ++i) sounds[i] = constant((i + 1) * 256, 4800);
+
+    int total = 0;
+    for (int i = 0; i < SFX_MAX_VOICES; ++i)
+    {
+        SFX_Play(sounds[i], priorities[i], 255, 0);
+        total += level((i + 1) * 256, 255);
+    }
+    SFX_Mix(out, 1);
+    CHECK_EQ(out[0], total);
+
+    SFX_Play(sounds[SFX_MAX_VOICES], priority, 255, 0);
+    SFX_Mix(out, 1);
+    if (out[0] == total) return -1;
+
+    const int missing = total + level((SFX_MAX_VOICES + 1) * 256, 255) - out[0];
+    for (int i = 0; i < SFX_MAX_VOICES; ++i)
+        if (missing == level((i + 1) * 256, 255)) return i;
+    return -2;
+}
+
+static void test_voice_stealing(void)
+{
+    const int equal[SFX_MAX_VOICES] = {0, 0, 0, 0, 0, 0, 0, 0};
+    CHECK_EQ(stealFrom(equal, 0), 0);
+    CHECK_EQ(SFX_GetStats().stolen, 1);
+
+    const int mixed[SFX_MAX_VOICES] = {2, 2, 1, 2, 1, 2, 2, 2};
+    CHECK_EQ(stealFrom(mixed, 1), 2);
+    CHECK_EQ(stealFrom(mixed, 5), 2);
+
+    const int busy[SFX_MAX_VOICES] = {3, 3, 3, 3, 3, 3, 3, 3};
+    CHECK_EQ(stealFrom(busy, 2), -1);
+    CHECK_EQ(SFX_GetStats().rejected, 1);
+    CHECK_EQ(SFX_GetStats().stolen, 0);
+}
+
+static void test_queue_overflow(void)
+{
+    reset();
+    const SFX_Sound sound = constant(100, 1000);
+
+    for (int i = 0; i < SFX_QUEUE_SIZE; ++i) CHECK_EQ(SFX_Play(sound, 0, 255, 0), 1);
+    CHECK_EQ(SFX_Play(sound, 0, 255, 0), 0);
+    CHECK_EQ(SFX_GetStats().dropped, 1);
+
+    SFX_Mix(out, 1);
+    const SFX_Stats stats = SFX_GetStats();
+    CHECK_EQ(stats.played, SFX_QUEUE_SIZE);
+    CHECK_EQ(stats.stolen, SFX_QUEUE_SIZE - SFX_MAX_VOICES);
+    CHECK_EQ(SFX_Play(sound, 0, 255, 0), 1);
+}
+
+static void test_stop_all(void)
+{
+    reset();
+    const SFX_Sound sound = constant(500, 1000);
+    SFX_Play(sound, 0, 255, 0);
+    SFX_Play(sound, 0, 255, 0);
+    SFX_Mix(out, 1);
+    CHECK_EQ(out[0], 2 * level(500, 255));
+
+    SFX_StopAll();
+    SFX_Mix(out, 1);
+    CHECK_EQ(out[0], 0);
+}
+
+static void test_tone(void)
+{
+    reset();
+    const SFX_Sound sound = SFX_LoadTone(SFX_WAVE_SQUARE, 1000, 1000, 10, 255);
+    SFX_Play(sound, 0, 255, 0);
+    SFX_Mix(out, 600);
+
+    CHECK_EQ(out[0], level(32767, 255));
+    int negative = 0;
+    for (int i = 0; i < 480; ++i) negative |= out[i * 2] < 0;
+    CHECK(negative);
+    CHECK_EQ(out[480 * 2], 0);
+}
+
+static void test_long_sound(void)
+{
+    reset();
+    // 96000 frames: more than the 65536 a 32-bit 16.16 position can count
+    const SFX_Sound sound = SFX_LoadTone(SFX_WAVE_SQUARE, 440, 440, 2000, 255);
+    SFX_Play(sound, 0, 255, 0);
+
+    int last = -1;
+    for (int call = 0; call < 120; ++call)
+    {
+        SFX_Mix(out, 1024);
+        for (int i = 0; i < 1024 * 2; ++i)
+            if (out[i]) last = call;
+    }
+    CHECK_EQ(last, 96000 / 1024);
+}
+
+static void test_invalid_tones(void)
+{
+    reset();
+    CHECK_EQ(SFX_LoadTone(SFX_WAVE_SQUARE, 440, 440, 0, 255), SFX_INVALID);
+    CHECK_EQ(SFX_LoadTone(SFX_WAVE_SQUARE, 440, 440, -1, 255), SFX_INVALID);
+    CHECK_EQ(SFX_LoadTone(SFX_WAVE_SQUARE, 440, 440, -2000000000, 255), SFX_INVALID);
+    // 2^31 ms is about 10^11 frames, which no longer fits the 32-bit cache size
+    CHECK_EQ(SFX_LoadTone(SFX_WAVE_SQUARE, 440, 440, 2147483647, 255), SFX_INVALID);
+}
+
+int main(void)
+{
+    SFX_Init();
+
+    RUN(test_volume_and_pan);
+    RUN(test_resampling);
+    RUN(test_formats);
+    RUN(test_clamping);
+    RUN(test_voice_stealing);
+    RUN(test_queue_overflow);
+    RUN(test_stop_all);
+    RUN(test_tone);
+    RUN(test_long_sound);
+    RUN(test_invalid_tones);
+
+    SFX_Shutdown();
+    return failures ? 1 : 0;
+}
@@ -8,6 +8,9 @@
 #include <asndlib.h>
 #include <mp3player.h>
 
+#include <render.h>
+#include <sfx.h>
+
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
 #define PLAYER_WIDTH 10
@@ -34,6 +37,7 @@ void initialize()
     WPAD_Init();
     ASND_Init();
     MP3Player_Init();
+    SFX_Init();
 
     screenMode = VIDEO_GetPreferredMode(NULL);
     framebuffer = MEM_K0_TO_K1(SYS_AllocateFramebuffer(screenMode));
@@ -93,6 +97,10 @@ int main()
     GRRLIB_ttfFont* font = GRRLIB_LoadTTF(fontBuffer, fontSize);
     if (!font) printf("Failed to load font!\n");
 
+    const SFX_Sound wallSound = SFX_LoadTone(SFX_WAVE_SQUARE, 440, 440, 40, 140);
+    const SFX_Sound paddleSound = SFX_LoadTone(SFX_WAVE_SQUARE, 880, 660, 60, 200);
+    const SFX_Sound scoreSound = SFX_LoadTone(SFX_WAVE_TRIANGLE, 660, 220, 300, 255);
+
     int gameStarted = 0, gameOver = 0, winner = 0, player1Score = 0, player2Score = 0;
     f32 player1Y = (SCREEN_HEIGHT - PLAYER_HEIGHT) / 2.0f, player2Y = (SCREEN_HEIGHT - PLAYER_HEIGHT) / 2.0f;
     f32 ballX = (SCREEN_WIDTH - BALL_SIZE) / 2.0f, ballY = (SCREEN_HEIGHT - BALL_SIZE) / 2.0f;
@@ -105,6 +113,7 @@ int main()
     printf("Start/restart game: A\n");
     printf("Exit: Home\n");
 
+    Render_Init();
     while (1)
     {
         WPAD_ScanPads();
@@ -157,11 +166,13 @@ int main()
             {
                 ballY = 0;
                 ballSpeedY = -ballSpeedY;
+                SFX_Play(wallSound, 0, 200, 0);
             }
             else if (ballY >= SCREEN_HEIGHT - BALL_SIZE)
             {
                 ballY = SCREEN_HEIGHT - BALL_SIZE;
                 ballSpeedY = -ballSpeedY;
+                SFX_Play(wallSound, 0, 200, 0);
             }
 
             const f32 p1X = 0;
@@ -173,6 +184,7 @@ int main()
             {
                 ballX = p1X + PLAYER_WIDTH;
                 ballSpeedX = -ballSpeedX;
+                SFX_Play(paddleSound, 1, 255, -96);
             }
 
             const int overlapP2Y = ballY + BALL_SIZE >= player2Y && ballY <= player2Y + PLAYER_HEIGHT;
@@ -182,12 +194,14 @@ int main()
             {
                 ballX = p2X - BALL_SIZE;
                 ballSpeedX = -ballSpeedX;
+                SFX_Play(paddleSound, 1, 255, 96);
             }
 
             if (ballX + BALL_SIZE < 0)
             {
                 player2Score++;
                 gameStarted = 0;
+                SFX_Play(scoreSound, 2, 255, -96);
 
                 ballX = (SCREEN_WIDTH - BALL_SIZE) / 2.0f;
                 ballY = (SCREEN_HEIGHT - BALL_SIZE) / 2.0f;
@@ -197,6 +211,7 @@ int main()
             {
                 player1Score++;
                 gameStarted = 0;
+                SFX_Play(scoreSound, 2, 255, 96);
 
                 ballX = (SCREEN_WIDTH - BALL_SIZE) / 2.0f;
                 ballY = (SCREEN_HEIGHT - BALL_SIZE) / 2.0f;
@@ -215,10 +230,11 @@ int main()
             }
         }
 
-        GRRLIB_FillScreen(0x000000FF);
-        GRRLIB_Rectangle(ballX, ballY, BALL_SIZE, BALL_SIZE, color, 1);
-        GRRLIB_Rectangle(0, player1Y, PLAYER_WIDTH, PLAYER_HEIGHT, color, 1);
-        GRRLIB_Rectangle(SCREEN_WIDTH - PLAYER_WIDTH, player2Y, PLAYER_WIDTH, PLAYER_HEIGHT, color, 1);
+        Render_Begin();
+        Render_FillScreen(0x000000FF);
+        Render_Rectangle(ballX, ballY, BALL_SIZE, BALL_SIZE, color, 1);
+        Render_Rectangle(0, player1Y, PLAYER_WIDTH, PLAYER_HEIGHT, color, 1);
+        Render_Rectangle(SCREEN_WIDTH - PLAYER_WIDTH, player2Y, PLAYER_WIDTH, PLAYER_HEIGHT, color, 1);
 
         if (font)
         {
@@ -226,27 +242,29 @@ int main()
             sprintf(p1ScoreStr, "P1: %d", player1Score);
             sprintf(p2ScoreStr, "P2: %d", player2Score);
 
-            GRRLIB_PrintfTTF(20, 20, font, p1ScoreStr, FONT_SIZE, color);
-            GRRLIB_PrintfTTF(SCREEN_WIDTH - 120, 20, font, p2ScoreStr, FONT_SIZE, color);
+            Render_Text(20, 20, font, p1ScoreStr, FONT_SIZE, color);
+            Render_Text(SCREEN_WIDTH - 120, 20, font, p2ScoreStr, FONT_SIZE, color);
 
             if (gameOver)
             {
-                GRRLIB_PrintfTTF(SCREEN_WIDTH / 2 - 80, SCREEN_HEIGHT / 2 - 20, font, "GAME OVER", FONT_SIZE, color);
-                GRRLIB_PrintfTTF(SCREEN_WIDTH / 2 - 80, SCREEN_HEIGHT / 2 + 0, font,
-                                 winner == 1 ? "P1 WINS!" : "P2 WINS!", FONT_SIZE, color);
-                GRRLIB_PrintfTTF(SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 + 20, font, "Press A to restart", FONT_SIZE,
-                                 color);
+                Render_Text(SCREEN_WIDTH / 2 - 80, SCREEN_HEIGHT / 2 - 20, font, "GAME OVER", FONT_SIZE, color);
+                Render_Text(SCREEN_WIDTH / 2 - 80, SCREEN_HEIGHT / 2 + 0, font, winner == 1 ? "P1 WINS!" : "P2 WINS!",
+                            FONT_SIZE, color);
+                Render_Text(SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT / 2 + 20, font, "Press A to restart", FONT_SIZE,
+                            color);
             }
             else if (!gameStarted)
-                GRRLIB_PrintfTTF(SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT - 40, font, "Press A to start", FONT_SIZE,
-                                 color);
+                Render_Text(SCREEN_WIDTH / 2 - 120, SCREEN_HEIGHT - 40, font, "Press A to start", FONT_SIZE, color);
         }
 
-        GRRLIB_Render();
+        Render_End();
     }
 
+    Render_Shutdown();
+
     free(musicBuffer);
     MP3Player_Stop();
+    SFX_Shutdown();
     GRRLIB_FreeTTF(font);
     GRRLIB_Exit();
 
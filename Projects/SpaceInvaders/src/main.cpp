@@ -10,6 +10,9 @@
 #include <asndlib.h>
 #include <mp3player.h>
 
+#include <render.h>
+#include <sfx.h>
+
 constexpr int SCREEN_WIDTH = 640, SCREEN_HEIGHT = 480;
 constexpr int PLAYER_SPEED = 5, BULLET_SPEED = 8, NUM_BULLETS = 5;
 constexpr int ENEMY_ROWS = 5, ENEMY_COLS = 11, ENEMY_WIDTH = 40, ENEMY_HEIGHT = 30, ENEMY_MARGIN = 10;
@@ -27,6 +30,7 @@ void initialize()
     WPAD_Init();
     ASND_Init();
     MP3Player_Init();
+    SFX_Init();
 
     screenMode = VIDEO_GetPreferredMode(nullptr);
     framebuffer = MEM_K0_TO_K1(SYS_AllocateFramebuffer(screenMode));
@@ -141,6 +145,7 @@ public:
 
     bool gameStarted = false;
     int score = 0, currentLevel = 1, enemyDirection = 1, enemyMoveCount = 0;
+    SFX_Sound shootSound = SFX_INVALID, hitSound = SFX_INVALID, levelSound = SFX_INVALID;
 
     Game()
     {
@@ -179,6 +184,7 @@ public:
                 b.x = player.x + (player.width - b.width) / 2.0f;
                 b.y = player.y - b.height;
                 b.active = true;
+                SFX_Play(shootSound, 1, 160, panFor(b.x));
 
                 break;
             }
@@ -228,11 +234,17 @@ public:
                         b.active = false;
                         e.alive = false;
                         score += 10;
+                        SFX_Play(hitSound, 2, 220, panFor(e.x));
 
                         break;
                     }
     }
 
+    [[nodiscard]] static int panFor(float x)
+    {
+        return static_cast<int>((x / SCREEN_WIDTH - 0.5f) * 254.0f);
+    }
+
     [[nodiscard]] bool allEnemiesDefeated() const
     {
         return std::none_of(enemies.begin(), enemies.end(), [](const Enemy& e) { return e.alive; });
@@ -268,11 +280,16 @@ int main()
     }
 
     Game game;
+    game.shootSound = SFX_LoadTone(SFX_WAVE_SQUARE, 1200, 300, 120, 180);
+    game.hitSound = SFX_LoadTone(SFX_WAVE_NOISE, 4000, 500, 250, 255);
+    game.levelSound = SFX_LoadTone(SFX_WAVE_TRIANGLE, 440, 1320, 400, 255);
+
     printf("Move: Left/Right\n");
     printf("Shoot: A\n");
     printf("Start/restart game: B\n");
     printf("Exit: Home\n");
 
+    Render_Init();
     while (true)
     {
         WPAD_ScanPads();
@@ -302,31 +319,35 @@ int main()
             {
                 game.currentLevel++;
                 game.resetLevel();
+                SFX_Play(game.levelSound, 3, 255, 0);
             }
         }
 
-        GRRLIB_FillScreen(0x000000FF);
-        GRRLIB_DrawImg(game.player.x, game.player.y, player_img, 0, 1, 1, 0xFFFFFFFF);
+        Render_Begin();
+        Render_FillScreen(0x000000FF);
+        Render_DrawImg(game.player.x, game.player.y, player_img, 0, 1, 1, 0xFFFFFFFF);
 
         for (const auto& b : game.bullets)
-            if (b.active) GRRLIB_Rectangle(b.x, b.y, b.width, b.height, 0xFFFFFFFF, true);
+            if (b.active) Render_Rectangle(b.x, b.y, b.width, b.height, 0xFFFFFFFF, true);
         for (const auto& e : game.enemies)
-            if (e.alive) GRRLIB_DrawImg(e.x, e.y, enemy_img, 0, 1, 1, 0xFFFFFFFF);
+            if (e.alive) Render_DrawImg(e.x, e.y, enemy_img, 0, 1, 1, 0xFFFFFFFF);
 
         if (font)
         {
             char scoreText[32];
             sprintf(scoreText, "Score: %d", game.score);
-            GRRLIB_PrintfTTF(10, 10, font, scoreText, 24, 0xFFFFFFFF);
+            Render_Text(10, 10, font, scoreText, 24, 0xFFFFFFFF);
             char levelText[32];
             sprintf(levelText, "Level: %d", game.currentLevel);
-            GRRLIB_PrintfTTF(SCREEN_WIDTH - 150, 10, font, levelText, 24, 0xFFFFFFFF);
+            Render_Text(SCREEN_WIDTH - 150, 10, font, levelText, 24, 0xFFFFFFFF);
         }
 
-        GRRLIB_Render();
+        Render_End();
     }
 
+    Render_Shutdown();
     MP3Player_Stop();
+    SFX_Shutdown();
     GRRLIB_FreeTTF(font);
     GRRLIB_FreeTexture(player_img);
     GRRLIB_FreeTexture(enemy_img);
@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+
+import argparse
+import re
+import shutil
+import struct
+import sys
+from pathlib import Path
+
+DOLPACK_MAGIC = 0x44504B31
+TEXT_SLOTS, DATA_SLOTS = 7, 11
+HEADER_SIZE = 0x100
+# The Homebrew Channel app booter lives here, so nothing we load may reach it
+LOADER_BASE = 0x81330000
+
+# The stub's _start mirrors libogc's crt0 ("_arg" at +4, the argv block at +8), then holds its __payload address
+STUB_MAGIC_OFFSET, STUB_PAYLOAD_OFFSET = 4, 32
+
+LZ_MIN, LZ_MAX, LZ_WINDOW, LZ_DEPTH = 3, 18, 4096, 32
+
+
+class Dol:
+    def __init__(self, text=None, data=None, bss=(0, 0), entry=0):
+        self.text = text or []
+        self.data = data or []
+        self.bss = bss
+        self.entry = entry
+
+    @classmethod
+    def load(cls, path):
+        raw = Path(path).read_bytes()
+        fields = struct.unpack_from(">" + "I" * 57, raw)
+        offsets, addresses, sizes = fields[0:18], fields[18:36], fields[36:54]
+
+        sections = [(addresses[i], raw[offsets[i]:offsets[i] + sizes[i]]) if sizes[i] else None for i in range(18)]
+        text = [s for s in sections[:TEXT_SLOTS] if s]
+        data = [s for s in sections[TEXT_SLOTS:] if s]
+        return cls(text, data, (fields[54], fields[55]), fields[56])
+
+    def sections(self):
+        return self.text + self.data
+
+    def end(self):
+        return max([a + len(d) for a, d in self.sections()] + [self.bss[0] + self.bss[1]])
+
+    def start(self):
+        return min(a for a, _ in self.sections())
+
+    def to_bytes(self):
+        if len(self.text) > TEXT_SLOTS or len(self.data) > DATA_SLOTS:
+            raise ValueError("too many DOL sections")
+
+        offsets, addresses, sizes = [0] * 18, [0] * 18, [0] * 18
+        body = bytearray()
+        slots = [(i, s) for i, s in enumerate(self.text)] + [(TEXT_SLOTS + i, s) for i, s in enumerate(self.data)]
+        for slot, (address, data) in slots:
+            data = data + b"\0" * (-len(data) % 32)
+            offsets[slot] = HEADER_SIZE + len(body)
+            addresses[slot] = address
+            sizes[slot] = len(data)
+            body += data
+
+        header = struct.pack(">" + "I" * 57, *offsets, *addresses, *sizes, *self.bss, self.entry)
+        return header + b"\0" * (HEADER_SIZE - len(header)) + bytes(body)
+
+    def save(self, path):
+        Path(path).write_bytes(self.to_bytes())
+
+
+def lz_compress(data):
+    out = bytearray()
+    chains = {}
+    i, n = 0, len(data)
+
+    def insert(pos):
+        if pos + LZ_MIN <= n:
+            chains.setdefault(data[pos:pos + LZ_MIN], []).append(pos)
+
+    while i < n:
+        flag_index = len(out)
+        out.append(0)
+
+        for bit in range(8):
+            if i >= n:
+                break
+
+            best_len, best_dist = 0, 0
+            candidates = chains.get(data[i:i + LZ_MIN]) if i + LZ_MIN <= n else None
+            if candidates:
+                limit = min(LZ_MAX, n - i)
+                for pos in reversed(candidates[-LZ_DEPTH:]):
+                    dist = i - pos
+                    if dist > LZ_WINDOW:
+                        break
+
+                    length = LZ_MIN
+                    while length < limit and data[pos + length] == data[i + length]:
+                        length += 1
+                    if length > best_len:
+                        best_len, best_dist = length, dist
+                        if length == limit:
+                            break
+
+            if best_len >= LZ_MIN:
+                out[flag_index] |= 0x80 >> bit
+                token = (best_len - LZ_MIN) << 12 | (best_dist - 1)
+                out += struct.pack(">H", token)
+                for pos in range(i, i + best_len):
+                    insert(pos)
+                i += best_len
+            else:
+                out.append(data[i])
+                insert(i)
+                i += 1
+
+    return bytes(out)
+
+
+def lz_decompress(data, size):
+    out = bytearray()
+    src = 0
+    while len(out) < size:
+        flags = data[src]
+        src += 1
+        for bit in range(8):
+            if len(out) >= size:
+                break
+            if flags & (0x80 >> bit):
+                token = data[src] << 8 | data[src + 1]
+                src += 2
+                start = len(out) - ((token & 0xFFF) + 1)
+                for k in range((token >> 12) + LZ_MIN):
+                    if len(out) >= size:
+                        break
+                    out.append(out[start + k])
+            else:
+                out.append(data[src])
+                src += 1
+    return bytes(out)
+
+
+def build_payload(dol):
+    sections = sorted(dol.sections())
+    table = bytearray(struct.pack(">5I", DOLPACK_MAGIC, dol.entry, dol.bss[0], dol.bss[1], len(sections)))
+    streams = bytearray()
+
+    for address, data in sections:
+        packed = lz_compress(data)
+        if len(packed) >= len(data):
+            # Already compressed data grows under LZSS, so it is stored; the stub copies sections whose sizes match
+            packed = data
+        elif lz_decompress(packed, len(data)) != data:
+            raise ValueError(f"round trip failed for section at 0x{address:08X}")
+
+        table += struct.pack(">3I", address, len(data), len(packed))
+        streams += packed + b"\0" * (-len(packed) % 4)
+
+    return bytes(table + streams)
+
+
+def stub_payload_address(stub):
+    for address, data in stub.text:
+        offset = stub.entry - address
+        if 0 <= offset and offset + STUB_PAYLOAD_OFFSET + 4 <= len(data):
+            if data[offset + STUB_MAGIC_OFFSET:offset + STUB_MAGIC_OFFSET + 4] != b"_arg":
+                break
+
+            payload_address = struct.unpack_from(">I", data, offset + STUB_PAYLOAD_OFFSET)[0]
+            if payload_address < stub.end() or payload_address % 4:
+                sys.exit(f"Stub payload address 0x{payload_address:08X} is inside the stub, or misaligned.")
+            return payload_address
+
+    sys.exit("Stub has no payload address at its entry point; rebuild it from stub.c.")
+
+
+def keep_unpacked(args, reason):
+    shutil.copyfile(args.input, args.output)
+    print(f"{Path(args.output).name}: {Path(args.input).stat().st_size} bytes, left uncompressed: {reason}")
+
+
+def cmd_pack(args):
+    stub = Dol.load(args.stub)
+    app = Dol.load(args.input)
+
+    # The unpacked DOL still boots in all of these cases, so they fall back to it rather than failing the build
+    if app.end() > stub.start():
+        return keep_unpacked(args, f"the image ends at 0x{app.end():08X}, past the stub at 0x{stub.start():08X}")
+
+    payload_address = stub_payload_address(stub)
+    payload = build_payload(app)
+    if payload_address + len(payload) > LOADER_BASE:
+        end = payload_address + len(payload)
+        return keep_unpacked(args, f"the payload would end at 0x{end:08X}, past the loader at 0x{LOADER_BASE:08X}")
+
+    image = Dol(stub.text, stub.data + [(payload_address, payload)], stub.bss, stub.entry).to_bytes()
+    before = Path(args.input).stat().st_size
+    if len(image) >= before:
+        return keep_unpacked(args, "packing does not make it smaller")
+
+    Path(args.output).write_bytes(image)
+    print(f"{Path(args.output).name}: {before} -> {len(image)} bytes ({100 * len(image) / before:.1f}%)")
+
+
+def section_kind(name):
+    if name.startswith((".text", ".init", ".fini")):
+        return "text"
+    if name.startswith((".rodata", ".sdata2", ".sbss2")):
+        return "rodata"
+    if name.startswith((".data", ".sdata", ".ctors", ".dtors", ".eh_frame", ".gcc_except_table")):
+        return "data"
+    if name.startswith((".bss", ".sbss", "COMMON")):
+        return "bss"
+    return None
+
+
+def library_name(path):
+    match = re.search(r"([^/\\]+\.a)\(", path)
+    return match.group(1) if match else "(objects)"
+
+
+def cmd_report(args):
+    lines = Path(args.map).read_text(errors="replace").splitlines()
+    kinds = ("text", "rodata", "data", "bss")
+    totals = {}
+    pending = None
+    started = False
+
+    entry = re.compile(r"^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            started = True
+            continue
+        if not started:
+            continue
+
+        match = entry.match(line)
+        if not match:
+            # Long input section names are printed on their own line
+            pending = line.strip() if re.match(r"^ \.\S+$", line) or line.strip() == "COMMON" else None
+            continue
+
+        name = match.group(1) or pending
+        pending = None
+        kind = section_kind(name or "")
+        size = int(match.group(3), 16)
+        if not kind or not size:
+            continue
+
+        library = totals.setdefault(library_name(match.group(4)), dict.fromkeys(kinds, 0))
+        library[kind] += size
+
+    rows = sorted(totals.items(), key=lambda item: sum(item[1].values()), reverse=True)
+    grand = {k: sum(sizes[k] for _, sizes in rows) for k in kinds}
+
+    out = [f"{'Library':<24}" + "".join(f"{k:>10}" for k in kinds) + f"{'total':>10}"]
+    for name, sizes in rows + [("total", grand)]:
+        out.append(f"{name:<24}" + "".join(f"{sizes[k]:>10}" for k in kinds) + f"{sum(sizes.values()):>10}")
+
+    report = "\n".join(out)
+    print(report)
+    if args.output:
+        Path(args.output).write_text(report + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(prog=Path(sys.argv[0]).name)
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    pack = sub.add_parser("pack", help="Compress a DOL behind the self-extracting stub")
+    pack.add_argument("--stub", type=Path, required=True, help="Stub DOL built from stub.c")
+    pack.add_argument("input", type=Path, help="DOL to compress")
+    pack.add_argument("output", type=Path, help="Packed DOL to write")
+
+    report = sub.add_parser("report", help="Print a per-library, per-section size report from a linker map")
+    report.add_argument("map", type=Path, help="Linker map file (-Wl,-Map=...)")
+    report.add_argument("-o", "--output", type=Path, help="Also write the report to this file")
+
+    args = parser.parse_args()
+
+    if args.cmd == "pack":
+        cmd_pack(args)
+    elif args.cmd == "report":
+        cmd_report(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,32 @@
+#ifndef DOLPACK_LZ_H
+#define DOLPACK_LZ_H
+
+#include <stdint.h>
+
+// LZSS as written by dolpack.py: a flag byte (MSB first) per 8 tokens. Set bits are matches of two bytes,
+// 4 bits length - 3 and 12 bits distance - 1. Clear bits are literal bytes.
+// Shared by the stub and the host tests, so it must stay freestanding.
+static void lzDecode(const uint8_t* src, uint8_t* dst, uint32_t size)
+{
+    uint8_t* const end = dst + size;
+    while (dst < end)
+    {
+        uint8_t flags = *src++;
+        for (int bit = 0; bit < 8 && dst < end; ++bit, flags <<= 1)
+        {
+            if (!(flags & 0x80))
+            {
+                *dst++ = *src++;
+                continue;
+            }
+
+            uint32_t length = (src[0] >> 4) + 3;
+            const uint8_t* from = dst - (((uint32_t)(src[0] & 0x0F) << 8 | src[1]) + 1);
+            src += 2;
+
+            while (length-- && dst < end) *dst++ = *from++;
+        }
+    }
+}
+
+#endif
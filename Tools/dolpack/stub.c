@@ -0,0 +1,102 @@
+// Self-extracting boot stub: unpacks the payload written by dolpack.py into place and jumps to it.
+// Built freestanding; keep it free of libc and of anything that needs the payload's memory.
+
+#include <stdint.h>
+
+#include "lz.h"
+
+#define DOLPACK_MAGIC 0x44504B31 // "DPK1"
+#define ARGV_MARKER 0x5F617267 // "_arg"
+#define STACK_SIZE 0x1000
+#define STRINGIFY(x) #x
+#define STR(x) STRINGIFY(x)
+
+typedef struct
+{
+    uint32_t magic, entry, bssAddress, bssSize, count;
+} PackHeader;
+
+typedef struct
+{
+    uint32_t address, size, packedSize;
+} PackSection;
+
+// libogc's __argv: the loader fills it in when it finds ARGV_MARKER at entry + 4, and the app's crt0 reserves its own
+typedef struct
+{
+    uint32_t magic, commandLine, length, argc, argv, end;
+} ArgvBlock;
+
+extern const uint8_t __payload[];
+extern ArgvBlock stubArgv;
+uint8_t stubStack[STACK_SIZE] __attribute__((aligned(16)));
+
+uint32_t unpack(void);
+
+__asm__(
+    "    .section .init, \"ax\"\n"
+    "    .globl _start\n"
+    "_start:\n"
+    "    b 1f\n"
+    "    .ascii \"_arg\"\n"
+    "    .globl stubArgv\n"
+    "stubArgv:\n"
+    "    .long 0, 0, 0, 0, 0, 0\n"
+    // Read by dolpack.py, so the payload goes where the linker script says rather than where the packer guesses
+    "    .long __payload\n"
+    "1:\n"
+    "    lis 1, (stubStack + " STR(STACK_SIZE) " - 16)@ha\n"
+    "    addi 1, 1, (stubStack + " STR(STACK_SIZE) " - 16)@l\n"
+    "    li 0, 0\n"
+    "    stw 0, 0(1)\n"
+    "    bl unpack\n"
+    "    mtctr 3\n"
+    "    bctr\n"
+    "    .previous\n");
+
+static void flushRange(uint32_t address, uint32_t size)
+{
+    const uint32_t end = address + size;
+    for (uint32_t line = address & ~31u; line < end; line += 32) __asm__ volatile("dcbst 0, %0" : : "r"(line));
+    __asm__ volatile("sync");
+
+    for (uint32_t line = address & ~31u; line < end; line += 32) __asm__ volatile("icbi 0, %0" : : "r"(line));
+    __asm__ volatile("sync; isync");
+}
+
+uint32_t unpack(void)
+{
+    const PackHeader* header = (const PackHeader*)__payload;
+    if (header->magic != DOLPACK_MAGIC)
+        while (1);
+
+    const PackSection* sections = (const PackSection*)(header + 1);
+    const uint8_t* stream = (const uint8_t*)(sections + header->count);
+
+    for (uint32_t i = 0; i < header->count; ++i)
+    {
+        uint8_t* dst = (uint8_t*)(uintptr_t)sections[i].address;
+        // dolpack.py stores sections that do not compress, marking them with equal sizes
+        if (sections[i].packedSize == sections[i].size)
+            for (uint32_t j = 0; j < sections[i].size; ++j) dst[j] = stream[j];
+        else lzDecode(stream, dst, sections[i].size);
+        flushRange(sections[i].address, sections[i].size);
+        stream += (sections[i].packedSize + 3) & ~3u;
+    }
+
+    // Hand the arguments on to the app, as if the loader had started it directly
+    uint32_t* marker = (uint32_t*)(uintptr_t)(header->entry + 4);
+    if (*marker == ARGV_MARKER)
+    {
+        uint32_t* argv = marker + 1;
+        const uint32_t* from = (const uint32_t*)&stubArgv;
+        for (uint32_t i = 0; i < sizeof(ArgvBlock) / 4; ++i) argv[i] = from[i];
+        flushRange(header->entry + 8, sizeof(ArgvBlock));
+    }
+
+    uint8_t* bss = (uint8_t*)(uintptr_t)header->bssAddress;
+    for (uint32_t i = 0; i < header->bssSize; ++i) bss[i] = 0;
+    flushRange(header->bssAddress, header->bssSize);
+
+    return header->entry;
+}
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# Tests dolpack.py and, through the lz_decode harness, the stub's decoder: dolpack_test.py <lz_decode>
+
+import contextlib
+import io
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+from types import SimpleNamespace
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+import dolpack  # noqa: E402
+
+LZ_DECODE = None
+
+
+def tokens(packed, size):
+    """Walks a stream the way the stub does, returning ("literal", 1, 0) / ("match", length, distance) tuples
+    and the number of flag bits left unused in the last flag byte."""
+    out, src, produced, unused = [], 0, 0, 0
+    while produced < size:
+        flags = packed[src]
+        src += 1
+        for bit in range(8):
+            if produced >= size:
+                unused = 8 - bit
+                break
+            if flags & (0x80 >> bit):
+                token = packed[src] << 8 | packed[src + 1]
+                src += 2
+                length = (token >> 12) + dolpack.LZ_MIN
+                out.append(("match", length, (token & 0xFFF) + 1))
+                produced += length
+            else:
+                out.append(("literal", 1, 0))
+                src += 1
+                produced += 1
+    return out, unused
+
+
+class Decoder(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def roundtrip(self, data):
+        packed = dolpack.lz_compress(data)
+        self.assertEqual(dolpack.lz_decompress(packed, len(data)), data)
+
+        (self.dir / "in.lz").write_bytes(packed)
+        subprocess.run([LZ_DECODE, self.dir / "in.lz", str(len(data)), self.dir / "out.bin"], check=True)
+        self.assertEqual((self.dir / "out.bin").read_bytes(), data)
+        return tokens(packed, len(data))
+
+    def test_literals(self):
+        # No 3-byte sequence repeats, so there is nothing to match
+        found, _ = self.roundtrip(bytes(range(256)))
+        self.assertTrue(all(kind == "literal" for kind, _, _ in found))
+
+    def test_overlapping_matches(self):
+        # Distance 1 and 2 matches copy bytes they have just written
+        found, _ = self.roundtrip(b"a" * 100 + b"xy" * 50)
+        self.assertIn(("match", dolpack.LZ_MAX, 1), found)
+        self.assertTrue(any(kind == "match" and distance == 2 for kind, _, distance in found))
+
+    def test_longest_and_farthest(self):
+        rng = random.Random(2)
+        block = bytes(rng.randrange(256) for _ in range(dolpack.LZ_MAX))
+        filler = bytes(rng.randrange(256) for _ in range(dolpack.LZ_WINDOW - len(block)))
+        found, _ = self.roundtrip(block + filler + block)
+        self.assertIn(("match", dolpack.LZ_MAX, dolpack.LZ_WINDOW), found)
+
+    def test_partial_flag_byte(self):
+        # 5 literals in one flag byte; 8 literals and a match that leaves the second flag byte 7 bits short
+        for data in (b"abcde", b"abcdefgh" + b"abc"):
+            found, unused = self.roundtrip(data)
+            self.assertNotEqual(len(found) % 8, 0)
+            self.assertEqual(unused, 8 - len(found) % 8)
+
+    def test_truncated_match(self):
+        # The stub stops at the section size even if the last match would run past it
+        packed = bytes([0x40]) + b"a" + struct.pack(">H", 0xF000)
+        (self.dir / "in.lz").write_bytes(packed)
+        subprocess.run([LZ_DECODE, self.dir / "in.lz", "10", self.dir / "out.bin"], check=True)
+        self.assertEqual((self.dir / "out.bin").read_bytes(), b"a" * 10)
+
+
+class Layout(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def test_dol_header(self):
+        text = [(0x80004000, b"\x60\x00\x00\x00" * 9), (0x80100000, b"t" * 64)]
+        data = [(0x80200000, b"d" * 33), (0x80300000, b"e"), (0x80400000, b"f" * 32)]
+        Dol = dolpack.Dol
+        Dol(text, data, (0x80500000, 0x1234), 0x80004000).save(self.dir / "a.dol")
+
+        raw = (self.dir / "a.dol").read_bytes()
+        fields = struct.unpack_from(">57I", raw)
+        offsets, addresses, sizes = fields[0:18], fields[18:36], fields[36:54]
+        self.assertEqual(addresses[:2], (0x80004000, 0x80100000))
+        self.assertEqual(addresses[7:10], (0x80200000, 0x80300000, 0x80400000))
+        self.assertEqual(sizes[:2] + sizes[7:10], (64, 64, 64, 32, 32))
+        self.assertEqual(sizes[2:7] + sizes[10:], (0,) * 13)
+        self.assertEqual(offsets[0], dolpack.HEADER_SIZE)
+        self.assertTrue(all(o % 32 == 0 for o in offsets))
+        self.assertEqual(fields[54:], (0x80500000, 0x1234, 0x80004000))
+        self.assertEqual(len(raw), dolpack.HEADER_SIZE + 64 * 3 + 32 * 2)
+
+        loaded = Dol.load(self.dir / "a.dol")
+        self.assertEqual([a for a, _ in loaded.text], [0x80004000, 0x80100000])
+        self.assertEqual(loaded.data[0], (0x80200000, b"d" * 33 + b"\0" * 31))
+        self.assertEqual((loaded.bss, loaded.entry), ((0x80500000, 0x1234), 0x80004000))
+        self.assertEqual(loaded.end(), 0x80500000 + 0x1234)
+
+        with self.assertRaises(ValueError):
+            Dol([(0x80004000 + i * 32, b"x") for i in range(8)]).save(self.dir / "b.dol")
+
+    @staticmethod
+    def make_stub(stub_address, payload_address=None, magic=b"_arg"):
+        # b 1f; "_arg"; the argv block; the payload address; code
+        if payload_address is None:
+            payload_address = stub_address + 0x1240
+        head = struct.pack(">I4s6II", 0x48000024, magic, *[0] * 6, payload_address)
+        return dolpack.Dol([(stub_address, head + b"\x60\x00\x00\x00" * 23)], [], (stub_address + 0x200, 0x1000),
+                           stub_address)
+
+    def pack(self, app, stub_address=0x81000000, stub=None):
+        stub = stub or self.make_stub(stub_address)
+        stub.save(self.dir / "stub.dol")
+        app.save(self.dir / "app.dol")
+        args = SimpleNamespace(stub=self.dir / "stub.dol", input=self.dir / "app.dol", output=self.dir / "out.dol")
+        dolpack.cmd_pack(args)
+        return dolpack.Dol.load(args.output), stub
+
+    def test_pack(self):
+        code = b"\x38\x60\x00\x00\x4e\x80\x00\x20" * 512
+        rng = random.Random(4)
+        noise = bytes(rng.randrange(256) for _ in range(512))
+        app = dolpack.Dol([(0x80004000, code)], [(0x80100000, noise)], (0x80200000, 0x100), 0x80004000)
+        packed, stub = self.pack(app)
+
+        self.assertEqual(packed.entry, stub.entry)
+        self.assertEqual(packed.text, stub.text)
+        address, payload = packed.data[-1]
+        self.assertEqual(address, 0x81001240)
+
+        magic, entry, bss_address, bss_size, count = struct.unpack_from(">5I", payload)
+        self.assertEqual((magic, entry, bss_address, bss_size, count),
+                         (dolpack.DOLPACK_MAGIC, 0x80004000, 0x80200000, 0x100, 2))
+
+        self.assertEqual(struct.unpack_from(">3I", payload, 32), (0x80100000, 512, 512))
+
+        stream = 20 + 12 * count
+        for i, (expected_address, expected) in enumerate(sorted(app.sections())):
+            section_address, size, packed_size = struct.unpack_from(">3I", payload, 20 + 12 * i)
+            self.assertEqual((section_address, size), (expected_address, len(expected)))
+
+            self.assertEqual(self.unpack(payload[stream:stream + packed_size], size), expected)
+            stream += (packed_size + 3) & ~3
+
+    def unpack(self, packed, size):
+        if len(packed) == size:
+            return packed
+
+        (self.dir / "in.lz").write_bytes(packed)
+        subprocess.run([LZ_DECODE, self.dir / "in.lz", str(size), self.dir / "out.bin"], check=True)
+        return (self.dir / "out.bin").read_bytes()
+
+    def assert_kept(self, app, reason, **kwargs):
+        output = io.StringIO()
+        with contextlib.redirect_stdout(output):
+            self.pack(app, **kwargs)
+        self.assertIn(reason, output.getvalue())
+        self.assertEqual((self.dir / "out.dol").read_bytes(), (self.dir / "app.dol").read_bytes())
+
+    def test_bad_stub(self):
+        app = dolpack.Dol([(0x80004000, b"\x38\x60\x00\x00" * 64)], [], (0, 0), 0x80004000)
+        with self.assertRaisesRegex(SystemExit, "no payload address"):
+            self.pack(app, stub=self.make_stub(0x81000000, magic=b"\0\0\0\0"))
+        with self.assertRaisesRegex(SystemExit, "inside the stub"):
+            self.pack(app, stub=self.make_stub(0x81000000, payload_address=0x81001000))
+
+    def test_incompressible(self):
+        # Packing would only add the stub
+        rng = random.Random(5)
+        noise = bytes(rng.randrange(256) for _ in range(0x4000))
+        self.assert_kept(dolpack.Dol([(0x80004000, noise)], [], (0, 0), 0x80004000), "does not make it smaller")
+
+    def test_overlapping_stub(self):
+        app = dolpack.Dol([(0x80004000, b"x" * 64)], [], (0x80004040, 0x81000000 - 0x80004040 + 4), 0x80004000)
+        self.assert_kept(app, "past the stub at 0x81000000")
+
+    def test_loader_base(self):
+        # Four symbols compress to about a third, still too much for the 64 KiB left between this stub and the loader
+        rng = random.Random(3)
+        app = dolpack.Dol([(0x80004000, bytes(rng.randrange(4) for _ in range(0x40000)))], [], (0, 0), 0x80004000)
+        self.assert_kept(app, "past the loader at 0x81330000", stub_address=0x81320000)
+
+
+if __name__ == "__main__":
+    LZ_DECODE = sys.argv.pop(1)
+    unittest.main()
@@ -0,0 +1,59 @@
+// Host harness for the stub's decoder: lz_decode <packed> <size> <output>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lz.h"
+
+static unsigned char* readFile(const char* path, long* size)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char* data = malloc((size_t)*size + 1);
+    if (data && fread(data, 1, (size_t)*size, file) != (size_t)*size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    return data;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "usage: %s <packed> <size> <output>\n", argv[0]);
+        return 2;
+    }
+
+    long packedSize = 0;
+    unsigned char* packed = readFile(argv[1], &packedSize);
+    const unsigned long size = strtoul(argv[2], NULL, 0);
+    unsigned char* out = malloc(size + 1);
+    if (!packed || !out)
+    {
+        fprintf(stderr, "Could not read %s\n", argv[1]);
+        return 1;
+    }
+
+    lzDecode(packed, out, (uint32_t)size);
+
+    FILE* file = fopen(argv[3], "wb");
+    if (!file || fwrite(out, 1, size, file) != size)
+    {
+        fprintf(stderr, "Could not write %s\n", argv[3]);
+        return 1;
+    }
+    fclose(file);
+
+    free(packed);
+    free(out);
+    return 0;
+}